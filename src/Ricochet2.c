@@ -6,7 +6,7 @@
 /* *      A watchface/app where the date and time bounce around      * */
 /* *           & ricochet off of each other and the walls            * */
 /* *                                                                 * */
-/* *                 [ SDK 2.0 compatible version ]                  * */
+/* *                 [ SDK 3.0 compatible version ]                  * */
 /* *                                                                 * */
 /* *                    by Mark J Culross, KD5RXT                    * */
 /* *                                                                 * */
@@ -36,6 +36,54 @@
 #define TOTAL_DATE_DIGITS 8
 #define TOTAL_BATT_DIGITS 4
 
+// Glyph sizes (the same image resources are used on every platform)
+#define BIG_DIGIT_WIDTH 21
+#define COLON_WIDTH 9
+#define DATE_DIGIT_WIDTH 13
+#define DATE_DIGIT_HEIGHT 18
+#define DATE_ROW_Y 23
+#define AMPM_WIDTH 10
+
+// total time field is 103w x 52h for 12-hour clock & 93w x 52h for 24-hour clock
+#define TIME_FIELD_WIDTH_24H ((4 * BIG_DIGIT_WIDTH) + COLON_WIDTH)
+#define TIME_FIELD_WIDTH_12H (TIME_FIELD_WIDTH_24H + AMPM_WIDTH)
+#define TIME_FIELD_HEIGHT 52
+
+// total date field is 104w x 41h, the battery block covers the right half of the day row
+#define DATE_FIELD_WIDTH (8 * DATE_DIGIT_WIDTH)
+#define DATE_FIELD_HEIGHT (DATE_ROW_Y + DATE_DIGIT_HEIGHT)
+#define BATT_FIELD_X (4 * DATE_DIGIT_WIDTH)
+#define BATT_FIELD_WIDTH (TOTAL_BATT_DIGITS * DATE_DIGIT_WIDTH)
+#define BATT_FIELD_HEIGHT DATE_DIGIT_HEIGHT
+
+// the date field has always bounced as 39h, 2 px short of its drawn height
+#define DATE_BOUNCE_HEIGHT (DATE_FIELD_HEIGHT - 2)
+
+// Screen layout, resolved at compile time for each target platform
+#if defined(PBL_PLATFORM_CHALK)
+// 180x180 round display, the fields bounce inside the 126x126 square inscribed in the circle
+#define LAYOUT_MIN_X 27
+#define LAYOUT_MIN_Y 27
+#define LAYOUT_MAX_X 153
+#define LAYOUT_MAX_Y 153
+#define LAYOUT_FREEZE_X 38
+#define LAYOUT_FREEZE_TOP_Y 31
+#define LAYOUT_FREEZE_BOTTOM_Y 96
+#define LAYOUT_SPLASH_X 18
+#define LAYOUT_SPLASH_Y 6
+#else
+// 144x168 rectangular display (aplite & basalt)
+#define LAYOUT_MIN_X 0
+#define LAYOUT_MIN_Y 0
+#define LAYOUT_MAX_X 143
+#define LAYOUT_MAX_Y 168
+#define LAYOUT_FREEZE_X 20
+#define LAYOUT_FREEZE_TOP_Y 10
+#define LAYOUT_FREEZE_BOTTOM_Y 75
+#define LAYOUT_SPLASH_X 0
+#define LAYOUT_SPLASH_Y 0
+#endif
+
 static Window *window;
 Layer *window_layer;
 
@@ -45,7 +93,16 @@ static GBitmap *date_image[TOTAL_DATE_DIGITS];
 static GBitmap *splash_image;
 static GBitmap *batt_image[TOTAL_BATT_DIGITS];
 
-static BitmapLayer *time_layer;
+// resource currently loaded into each bitmap, so a glyph is only reloaded when it changes
+static int time_digits_resource_id[TOTAL_TIME_DIGITS];
+static int day_resource_id;
+static int date_resource_id[TOTAL_DATE_DIGITS];
+static int splash_resource_id;
+static int batt_resource_id[TOTAL_BATT_DIGITS];
+
+static Layer *time_layer;
+static Layer *date_layer;
+static Layer *batt_layer;
 
 bool night_enabled = NIGHT_ENABLED_DEFAULT;
 bool clock_24h_style = CLOCK_24H_STYLE_DEFAULT;
@@ -64,7 +121,7 @@ int time_y_delta = 3;
 int time_x_offset = 0;
 int time_y_offset = 0;
 
-int date_x_max = 104;
+int date_x_max = DATE_FIELD_WIDTH;
 
 int date_x_delta = -3;
 int date_y_delta = -2;
@@ -72,8 +129,6 @@ int date_y_delta = -2;
 int date_x_offset = 0;
 int date_y_offset = 0;
 
-BatteryChargeState batt_state;
-
 
 const int BIG_DIGIT_IMAGE_RESOURCE_IDS[] =
 {
@@ -121,18 +176,32 @@ const int DAY_IMAGE_RESOURCE_IDS[] =
 static void click_config_provider(void *context);
 static void deinit(void);
 static void down_single_click_handler(ClickRecognizerRef recognizer, void *context);
+static void draw_bitmap_image(GContext *ctx, GBitmap *bmp_image, GPoint this_origin, bool invert);
 static void handle_accel_tap(AccelAxisType axis, int32_t direction);
 static void handle_second_tick(struct tm *tick, TimeUnits units_changed);
 static void init(void);
+#if defined(PBL_COLOR)
+static void invert_all_palettes(void);
+static void invert_bitmap_palette(GBitmap *bmp_image);
+#endif
+static bool load_bitmap_image(GBitmap **bmp_image, int *bmp_resource_id, const int resource_id, bool invert);
+static void select_batt_glyphs(BatteryChargeState batt_state, int resource_ids[TOTAL_BATT_DIGITS]);
+static void select_date_glyphs(const struct tm *current_time, int *day_id, int resource_ids[TOTAL_DATE_DIGITS]);
 static void select_long_click_handler(ClickRecognizerRef recognizer, void *context);
 static void select_long_release_handler(ClickRecognizerRef recognizer, void *context);
 static void select_single_click_handler(ClickRecognizerRef recognizer, void *context);
-static void set_bitmap_image(GContext *ctx, GBitmap **bmp_image, const int resource_id, GPoint this_origin, bool invert);
+static void select_time_glyphs(const struct tm *current_time, bool clock_24h, int resource_ids[TOTAL_TIME_DIGITS]);
 static void up_single_click_handler(ClickRecognizerRef recognizer, void *context);
+static void update_batt(Layer *layer, GContext *ctx);
+static bool update_batt_images(BatteryChargeState batt_state);
 static void update_date(Layer *layer, GContext *ctx);
+static bool update_date_images(const struct tm *current_time);
 static void update_display(Layer *layer, GContext *ctx);
+static void update_images(const struct tm *current_time, BatteryChargeState batt_state);
+static void update_layers(void);
 static void update_moves(void);
 static void update_time(Layer *layer, GContext *ctx);
+static bool update_time_images(const struct tm *current_time);
 
 
 
@@ -153,8 +222,14 @@ static void deinit(void)
    persist_write_int(PKEY_DATE_MONTH_FIRST, date_month_first);
    persist_write_int(PKEY_TIME_ON_TOP, time_on_top);
 
-   layer_remove_from_parent(bitmap_layer_get_layer(time_layer));
-   bitmap_layer_destroy(time_layer);
+   layer_remove_from_parent(batt_layer);
+   layer_destroy(batt_layer);
+
+   layer_remove_from_parent(date_layer);
+   layer_destroy(date_layer);
+
+   layer_remove_from_parent(time_layer);
+   layer_destroy(time_layer);
 
    for (int i = 0; i < TOTAL_TIME_DIGITS; i++)
    {
@@ -192,18 +267,67 @@ static void down_single_click_handler(ClickRecognizerRef recognizer, void *conte
 
       if (clock_24h_style)
       {
-         time_x_max = 93;
+         time_x_max = TIME_FIELD_WIDTH_24H;
       }
       else
       {
-         time_x_max = 103;
+         time_x_max = TIME_FIELD_WIDTH_12H;
       }
 
-      layer_mark_dirty(window_layer);
+      time_t t = time(NULL);
+      update_time_images(localtime(&t));
+
+      layer_mark_dirty(time_layer);
    }
 }  // down_single_click_handler()
 
 
+#if defined(PBL_COLOR)
+static void draw_bitmap_image(GContext *ctx, GBitmap *bmp_image, GPoint this_origin, bool invert)
+{
+   // 8-bit framebuffer: night mode is already applied to a palettized glyph, so this is a straight copy
+   GRect frame = (GRect)
+   {
+      .origin = this_origin,
+      .size = gbitmap_get_bounds(bmp_image).size
+   };
+
+   if (invert && (gbitmap_get_format(bmp_image) == GBitmapFormat1Bit))
+   {
+      // a plain 1-bit glyph has no palette to invert, so invert it while blitting
+      graphics_context_set_compositing_mode(ctx, GCompOpAssignInverted);
+   }
+   else
+   {
+      graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+   }
+
+   graphics_draw_bitmap_in_rect(ctx, bmp_image, frame);
+}  // draw_bitmap_image()
+#else
+static void draw_bitmap_image(GContext *ctx, GBitmap *bmp_image, GPoint this_origin, bool invert)
+{
+   // 1-bit framebuffer: night mode inverts the glyph while blitting
+   GRect frame = (GRect)
+   {
+      .origin = this_origin,
+      .size = gbitmap_get_bounds(bmp_image).size
+   };
+
+   if (invert)
+   {
+      graphics_context_set_compositing_mode(ctx, GCompOpAssignInverted);
+   }
+   else
+   {
+      graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+   }
+
+   graphics_draw_bitmap_in_rect(ctx, bmp_image, frame);
+}  // draw_bitmap_image()
+#endif
+
+
 static void handle_accel_tap(AccelAxisType axis, int32_t direction)
 {
    freeze_timer = 4;
@@ -220,6 +344,8 @@ static void handle_accel_tap(AccelAxisType axis, int32_t direction)
       light_enable(false);
    }
 
+   update_layers();
+
    layer_mark_dirty(window_layer);
 }  // accel_tap_handler()
 
@@ -229,6 +355,12 @@ void handle_second_tick(struct tm *tick_time, TimeUnits units_changed)
    if (splash_timer > 0)
    {
       splash_timer--;
+
+      if (splash_timer == 0)
+      {
+         // swap the splash screen for the plain background
+         layer_mark_dirty(window_layer);
+      }
    }
    else
    {
@@ -244,14 +376,18 @@ void handle_second_tick(struct tm *tick_time, TimeUnits units_changed)
       }
    }
 
-   layer_mark_dirty(window_layer);
+   if ((splash_timer == 0) && (freeze_timer == 0))
+   {
+      update_moves();
+   }
+
+   update_images(tick_time, battery_state_service_peek());
+   update_layers();
 }  // handle_second_tick()
 
 
 static void init(void)
 {
-   GRect dummy_frame = { {0, 0}, {0, 0} };
-
    window = window_create();
    if (window == NULL)
    {
@@ -280,11 +416,11 @@ static void init(void)
 
    if (clock_24h_style)
    {
-      time_x_max = 93;
+      time_x_max = TIME_FIELD_WIDTH_24H;
    }
    else
    {
-      time_x_max = 103;
+      time_x_max = TIME_FIELD_WIDTH_12H;
    }
 
    // Get all settings from persistent storage for use if they exist, otherwise use the default
@@ -292,39 +428,199 @@ static void init(void)
    date_month_first = persist_exists(PKEY_DATE_MONTH_FIRST) ? persist_read_int(PKEY_DATE_MONTH_FIRST) : DATE_MONTH_FIRST_DEFAULT;
    time_on_top = persist_exists(PKEY_TIME_ON_TOP) ? persist_read_int(PKEY_TIME_ON_TOP) : TIME_ON_TOP_DEFAULT;
 
-   window_set_fullscreen(window, true);
    window_stack_push(window, true /* Animated */);
 
    window_set_click_config_provider(window, click_config_provider);
    layer_set_update_proc(window_layer, update_display);
 
-   splash_image = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_SPLASH);
+   splash_resource_id = RESOURCE_ID_IMAGE_SPLASH;
+   splash_image = gbitmap_create_with_resource(splash_resource_id);
  
-   day_image = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_DAY_SUN);
+   day_resource_id = RESOURCE_ID_IMAGE_DAY_SUN;
+   day_image = gbitmap_create_with_resource(day_resource_id);
  
    for (int i = 0; i < TOTAL_BATT_DIGITS; i++)
    {
-      batt_image[i] = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_DATENUM_0); 
+      batt_resource_id[i] = RESOURCE_ID_IMAGE_DATENUM_0;
+      batt_image[i] = gbitmap_create_with_resource(batt_resource_id[i]); 
    }
 
    for (int i = 0; i < TOTAL_DATE_DIGITS; i++)
    {
-      date_image[i] = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_DATENUM_0); 
+      date_resource_id[i] = RESOURCE_ID_IMAGE_DATENUM_0;
+      date_image[i] = gbitmap_create_with_resource(date_resource_id[i]); 
    }
 
    for (int i = 0; i < TOTAL_TIME_DIGITS; i++)
    {
-      time_digits_image[i] = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_NUM_0); 
+      time_digits_resource_id[i] = RESOURCE_ID_IMAGE_NUM_0;
+      time_digits_image[i] = gbitmap_create_with_resource(time_digits_resource_id[i]); 
+   }
+
+#if defined(PBL_COLOR)
+   if (night_enabled)
+   {
+      invert_all_palettes();
    }
+#endif
 
-   time_layer = bitmap_layer_create(dummy_frame);
-   layer_add_child(window_layer, bitmap_layer_get_layer(time_layer));
+   // the AM/PM slot is always drawn (blank for 24-hour clock), so the time layer is sized for 12-hour clock
+   time_layer = layer_create(GRect(0, 0, TIME_FIELD_WIDTH_12H, TIME_FIELD_HEIGHT));
+   layer_set_update_proc(time_layer, update_time);
+   layer_add_child(window_layer, time_layer);
+
+   date_layer = layer_create(GRect(0, 0, DATE_FIELD_WIDTH, DATE_FIELD_HEIGHT));
+   layer_set_update_proc(date_layer, update_date);
+   layer_add_child(window_layer, date_layer);
+
+   batt_layer = layer_create(GRect(BATT_FIELD_X, 0, BATT_FIELD_WIDTH, BATT_FIELD_HEIGHT));
+   layer_set_update_proc(batt_layer, update_batt);
+   layer_add_child(window_layer, batt_layer);
+
+   time_t t = time(NULL);
+   update_images(localtime(&t), battery_state_service_peek());
+   update_layers();
 
    accel_tap_service_subscribe(&handle_accel_tap);
    tick_timer_service_subscribe(SECOND_UNIT, &handle_second_tick);
 }  // init()
 
 
+#if defined(PBL_COLOR)
+static void invert_all_palettes(void)
+{
+   for (int i = 0; i < TOTAL_TIME_DIGITS; i++)
+   {
+      invert_bitmap_palette(time_digits_image[i]);
+   }
+
+   for (int i = 0; i < TOTAL_DATE_DIGITS; i++)
+   {
+      invert_bitmap_palette(date_image[i]);
+   }
+
+   for (int i = 0; i < TOTAL_BATT_DIGITS; i++)
+   {
+      invert_bitmap_palette(batt_image[i]);
+   }
+
+   invert_bitmap_palette(day_image);
+
+   invert_bitmap_palette(splash_image);
+}  // invert_all_palettes()
+
+
+static void invert_bitmap_palette(GBitmap *bmp_image)
+{
+   // the 1-bit images normally load as 2-color palettized bitmaps, so inverting the palette inverts the glyph
+   int palette_size = 0;
+
+   switch (gbitmap_get_format(bmp_image))
+   {
+      case GBitmapFormat1BitPalette:
+         palette_size = 2;
+         break;
+
+      case GBitmapFormat2BitPalette:
+         palette_size = 4;
+         break;
+
+      case GBitmapFormat4BitPalette:
+         palette_size = 16;
+         break;
+
+      case GBitmapFormat1Bit:
+         // inverted by draw_bitmap_image() instead
+         return;
+
+      default:
+         APP_LOG(APP_LOG_LEVEL_WARNING, "...can't invert a bitmap in this format for night mode...");
+         return;
+   }
+
+   GColor *palette = gbitmap_get_palette(bmp_image);
+
+   for (int i = 0; i < palette_size; i++)
+   {
+      // flip the RGB bits, keep the alpha bits
+      palette[i].argb ^= 0x3F;
+   }
+}  // invert_bitmap_palette()
+#endif
+
+
+static bool load_bitmap_image(GBitmap **bmp_image, int *bmp_resource_id, const int resource_id, bool invert)
+{
+   if (*bmp_resource_id == resource_id)
+   {
+      return false;
+   }
+
+   gbitmap_destroy(*bmp_image);
+
+   *bmp_image = gbitmap_create_with_resource(resource_id);
+   *bmp_resource_id = resource_id;
+
+#if defined(PBL_COLOR)
+   if (invert)
+   {
+      invert_bitmap_palette(*bmp_image);
+   }
+#endif
+
+   return true;
+}  // load_bitmap_image()
+
+
+static void select_batt_glyphs(BatteryChargeState batt_state, int resource_ids[TOTAL_BATT_DIGITS])
+{
+   if (batt_state.charge_percent < 100)
+   {
+      if (batt_state.is_charging)
+      {
+         resource_ids[0] = RESOURCE_ID_IMAGE_DATENUM_PLUS;
+      }
+      else
+      {
+         resource_ids[0] = RESOURCE_ID_IMAGE_DATENUM_BLANK;
+      }
+   }
+   else
+   {
+      resource_ids[0] = RESOURCE_ID_IMAGE_DATENUM_1;
+   }
+
+   batt_state.charge_percent %= 100;
+
+   if (batt_state.charge_percent < 10)
+   {
+      resource_ids[1] = RESOURCE_ID_IMAGE_DATENUM_BLANK;
+   }
+   else
+   {
+      resource_ids[1] = DATENUM_IMAGE_RESOURCE_IDS[batt_state.charge_percent / 10];
+   }
+
+   resource_ids[2] = DATENUM_IMAGE_RESOURCE_IDS[batt_state.charge_percent % 10];
+   resource_ids[3] = RESOURCE_ID_IMAGE_DATENUM_PERCENT;
+}  // select_batt_glyphs()
+
+
+static void select_date_glyphs(const struct tm *current_time, int *day_id, int resource_ids[TOTAL_DATE_DIGITS])
+{
+   *day_id = DAY_IMAGE_RESOURCE_IDS[current_time->tm_wday];
+
+   resource_ids[0] = DATENUM_IMAGE_RESOURCE_IDS[(current_time->tm_mon + 1) / 10];
+   resource_ids[1] = DATENUM_IMAGE_RESOURCE_IDS[(current_time->tm_mon + 1) % 10];
+   resource_ids[2] = RESOURCE_ID_IMAGE_DATENUM_SLASH;
+   resource_ids[3] = DATENUM_IMAGE_RESOURCE_IDS[current_time->tm_mday / 10];
+   resource_ids[4] = DATENUM_IMAGE_RESOURCE_IDS[current_time->tm_mday % 10];
+   resource_ids[5] = RESOURCE_ID_IMAGE_DATENUM_SLASH;
+   resource_ids[6] = DATENUM_IMAGE_RESOURCE_IDS[(current_time->tm_year / 10) % 10];
+   resource_ids[7] = DATENUM_IMAGE_RESOURCE_IDS[current_time->tm_year % 10];
+}  // select_date_glyphs()
+
+
 static void select_long_click_handler(ClickRecognizerRef recognizer, void *context)
 {
    if (splash_timer == 0)
@@ -334,6 +630,10 @@ static void select_long_click_handler(ClickRecognizerRef recognizer, void *conte
       // Save night_enabled setting into persistent storage
       persist_write_int(PKEY_NIGHT_ENABLED, night_enabled);
 
+#if defined(PBL_COLOR)
+      invert_all_palettes();
+#endif
+
       layer_mark_dirty(window_layer);
    }
 }  // select_long_click_handler()
@@ -392,35 +692,60 @@ static void select_single_click_handler(ClickRecognizerRef recognizer, void *con
       }
    }
 
+   update_layers();
+
    layer_mark_dirty(window_layer);
 }  // select_single_click_handler()
 
 
-static void set_bitmap_image(GContext *ctx, GBitmap **bmp_image, const int resource_id, GPoint this_origin, bool invert)
+static void select_time_glyphs(const struct tm *current_time, bool clock_24h, int resource_ids[TOTAL_TIME_DIGITS])
 {
-   gbitmap_destroy(*bmp_image);
-
-   *bmp_image = gbitmap_create_with_resource(resource_id);
-
-   GRect frame = (GRect)
+   // display time hour
+   if (clock_24h)
    {
-      .origin = this_origin,
-      .size = (*bmp_image)->bounds.size
-   };
+      resource_ids[0] = BIG_DIGIT_IMAGE_RESOURCE_IDS[current_time->tm_hour / 10];
+      resource_ids[1] = BIG_DIGIT_IMAGE_RESOURCE_IDS[current_time->tm_hour % 10];
 
-   if (invert)
-   {
-      graphics_context_set_compositing_mode(ctx, GCompOpAssignInverted);
+      // display blank in place of AM/PM
+      resource_ids[5] = RESOURCE_ID_IMAGE_BLANK_MODE;
    }
    else
    {
-      graphics_context_set_compositing_mode(ctx, GCompOpAssign);
-   }
+      // display AM/PM
+      if (current_time->tm_hour >= 12)
+      {
+         resource_ids[5] = RESOURCE_ID_IMAGE_PM_MODE;
+      }
+      else
+      {
+         resource_ids[5] = RESOURCE_ID_IMAGE_AM_MODE;
+      }
+
+      if ((current_time->tm_hour % 12) == 0)
+      {
+         resource_ids[0] = BIG_DIGIT_IMAGE_RESOURCE_IDS[1];
+         resource_ids[1] = BIG_DIGIT_IMAGE_RESOURCE_IDS[2];
+      }
+      else
+      {
+         if ((current_time->tm_hour % 12) < 10)
+         {
+            resource_ids[0] = RESOURCE_ID_IMAGE_NUM_BLANK;
+         }
+         else
+         {
+            resource_ids[0] = BIG_DIGIT_IMAGE_RESOURCE_IDS[(current_time->tm_hour % 12) / 10];
+         }
 
-   graphics_draw_bitmap_in_rect(ctx, *bmp_image, frame);
+         resource_ids[1] = BIG_DIGIT_IMAGE_RESOURCE_IDS[(current_time->tm_hour % 12) % 10];
+      }
+   }
 
-   layer_mark_dirty(window_layer);
-}  // set_bitmap_image()
+   // display colon & time minute
+   resource_ids[2] = RESOURCE_ID_IMAGE_COLON;
+   resource_ids[3] = BIG_DIGIT_IMAGE_RESOURCE_IDS[current_time->tm_min / 10];
+   resource_ids[4] = BIG_DIGIT_IMAGE_RESOURCE_IDS[current_time->tm_min % 10];
+}  // select_time_glyphs()
 
 
 static void up_single_click_handler(ClickRecognizerRef recognizer, void *context)
@@ -432,104 +757,169 @@ static void up_single_click_handler(ClickRecognizerRef recognizer, void *context
       // Save date_month_first setting into persistent storage
       persist_write_int(PKEY_DATE_MONTH_FIRST, date_month_first);
 
-      layer_mark_dirty(window_layer);
+      layer_mark_dirty(date_layer);
    }
 }  // up_single_click_handler()
 
 
-static void update_date(Layer *layer, GContext *ctx)
+static void update_batt(Layer *layer, GContext *ctx)
 {
-   time_t t = time(NULL);
-   struct tm *current_time = localtime(&t);
+   for (int i = 0; i < TOTAL_BATT_DIGITS; i++)
+   {
+      draw_bitmap_image(ctx, batt_image[i], GPoint(i * DATE_DIGIT_WIDTH, 0), night_enabled);
+   }
+}  // update_batt()
 
-   if (freeze_timer > 0)
+
+static bool update_batt_images(BatteryChargeState batt_state)
+{
+   int resource_ids[TOTAL_BATT_DIGITS];
+   bool changed = false;
+
+   select_batt_glyphs(batt_state, resource_ids);
+
+   for (int i = 0; i < TOTAL_BATT_DIGITS; i++)
    {
-      if (time_on_top)
-      {
-         date_x_offset = 20;
-         date_y_offset = 75;
-      }
-      else
-      {
-         date_x_offset = 20;
-         date_y_offset = 10;
-      }
+      changed |= load_bitmap_image(&batt_image[i], &batt_resource_id[i], resource_ids[i], night_enabled);
    }
 
+   return changed;
+}  // update_batt_images()
+
+
+static void update_date(Layer *layer, GContext *ctx)
+{
    // display date
-   set_bitmap_image(ctx, &day_image, DAY_IMAGE_RESOURCE_IDS[current_time->tm_wday], GPoint(date_x_offset, date_y_offset), night_enabled);
+   draw_bitmap_image(ctx, day_image, GPoint(0, 0), night_enabled);
 
-   batt_state = battery_state_service_peek();
-   if (batt_state.charge_percent < 100)
+   if (date_month_first)
    {
-      if (batt_state.is_charging)
-      {
-         set_bitmap_image(ctx, &batt_image[0], RESOURCE_ID_IMAGE_DATENUM_PLUS, GPoint(date_x_offset+52, date_y_offset), night_enabled);
-      }
-      else
-      {
-         set_bitmap_image(ctx, &batt_image[0], RESOURCE_ID_IMAGE_DATENUM_BLANK, GPoint(date_x_offset+52, date_y_offset), night_enabled);
-      }
+      draw_bitmap_image(ctx, date_image[0], GPoint(0, DATE_ROW_Y), night_enabled);
+      draw_bitmap_image(ctx, date_image[1], GPoint(DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
+      draw_bitmap_image(ctx, date_image[3], GPoint(3 * DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
+      draw_bitmap_image(ctx, date_image[4], GPoint(4 * DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
    }
    else
    {
-      set_bitmap_image(ctx, &batt_image[0], RESOURCE_ID_IMAGE_DATENUM_1, GPoint(date_x_offset+52, date_y_offset), night_enabled);
+      draw_bitmap_image(ctx, date_image[3], GPoint(0, DATE_ROW_Y), night_enabled);
+      draw_bitmap_image(ctx, date_image[4], GPoint(DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
+      draw_bitmap_image(ctx, date_image[0], GPoint(3 * DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
+      draw_bitmap_image(ctx, date_image[1], GPoint(4 * DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
    }
 
-   batt_state.charge_percent %= 100;
+   draw_bitmap_image(ctx, date_image[6], GPoint(6 * DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
+   draw_bitmap_image(ctx, date_image[7], GPoint(7 * DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
+   draw_bitmap_image(ctx, date_image[2], GPoint(2 * DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
+   draw_bitmap_image(ctx, date_image[5], GPoint(5 * DATE_DIGIT_WIDTH, DATE_ROW_Y), night_enabled);
+}  // update_date()
 
-   if (batt_state.charge_percent < 10)
+
+static bool update_date_images(const struct tm *current_time)
+{
+   int day_id;
+   int resource_ids[TOTAL_DATE_DIGITS];
+   bool changed = false;
+
+   select_date_glyphs(current_time, &day_id, resource_ids);
+
+   changed |= load_bitmap_image(&day_image, &day_resource_id, day_id, night_enabled);
+
+   for (int i = 0; i < TOTAL_DATE_DIGITS; i++)
    {
-      set_bitmap_image(ctx, &batt_image[1], RESOURCE_ID_IMAGE_DATENUM_BLANK, GPoint(date_x_offset+65, date_y_offset), night_enabled);
+      changed |= load_bitmap_image(&date_image[i], &date_resource_id[i], resource_ids[i], night_enabled);
+   }
+
+   return changed;
+}  // update_date_images()
+
+
+static void update_display(Layer *layer, GContext *ctx)
+{
+   // only the background is drawn here, the time, date & battery blocks are child layers
+#if defined(PBL_COLOR)
+   // the background images only cover 144x168, so fill the whole screen & center the splash on it
+   if (night_enabled)
+   {
+      graphics_context_set_fill_color(ctx, GColorBlack);
    }
    else
    {
-      set_bitmap_image(ctx, &batt_image[1], DATENUM_IMAGE_RESOURCE_IDS[batt_state.charge_percent / 10], GPoint(date_x_offset+65, date_y_offset), night_enabled);
+      graphics_context_set_fill_color(ctx, GColorWhite);
    }
 
-   set_bitmap_image(ctx, &batt_image[2], DATENUM_IMAGE_RESOURCE_IDS[batt_state.charge_percent % 10], GPoint(date_x_offset+78, date_y_offset), night_enabled);
-   set_bitmap_image(ctx, &batt_image[3], RESOURCE_ID_IMAGE_DATENUM_PERCENT, GPoint(date_x_offset+91, date_y_offset), night_enabled);
+   graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
 
-   if (date_month_first)
+   if (splash_timer > 0)
    {
-      set_bitmap_image(ctx, &date_image[0], DATENUM_IMAGE_RESOURCE_IDS[(current_time->tm_mon + 1) / 10], GPoint(date_x_offset, date_y_offset + 23), night_enabled);
-      set_bitmap_image(ctx, &date_image[1], DATENUM_IMAGE_RESOURCE_IDS[(current_time->tm_mon + 1) % 10], GPoint(date_x_offset + 13, date_y_offset + 23), night_enabled);
-      set_bitmap_image(ctx, &date_image[3], DATENUM_IMAGE_RESOURCE_IDS[current_time->tm_mday / 10], GPoint(date_x_offset + 39, date_y_offset + 23), night_enabled);
-      set_bitmap_image(ctx, &date_image[4], DATENUM_IMAGE_RESOURCE_IDS[current_time->tm_mday % 10], GPoint(date_x_offset + 52, date_y_offset + 23), night_enabled);
+      draw_bitmap_image(ctx, splash_image, GPoint(LAYOUT_SPLASH_X, LAYOUT_SPLASH_Y), night_enabled);
+   }
+#else
+   if (splash_timer == 0)
+   {
+      load_bitmap_image(&splash_image, &splash_resource_id, RESOURCE_ID_IMAGE_WHITE_BACK, night_enabled);
    }
    else
    {
-      set_bitmap_image(ctx, &date_image[3], DATENUM_IMAGE_RESOURCE_IDS[current_time->tm_mday / 10], GPoint(date_x_offset, date_y_offset + 23), night_enabled);
-      set_bitmap_image(ctx, &date_image[4], DATENUM_IMAGE_RESOURCE_IDS[current_time->tm_mday % 10], GPoint(date_x_offset + 13, date_y_offset + 23), night_enabled);
-      set_bitmap_image(ctx, &date_image[0], DATENUM_IMAGE_RESOURCE_IDS[(current_time->tm_mon + 1) / 10], GPoint(date_x_offset + 39, date_y_offset + 23), night_enabled);
-      set_bitmap_image(ctx, &date_image[1], DATENUM_IMAGE_RESOURCE_IDS[(current_time->tm_mon + 1) % 10], GPoint(date_x_offset + 52, date_y_offset + 23), night_enabled);
+      load_bitmap_image(&splash_image, &splash_resource_id, RESOURCE_ID_IMAGE_SPLASH, night_enabled);
    }
 
-   set_bitmap_image(ctx, &date_image[6], DATENUM_IMAGE_RESOURCE_IDS[(current_time->tm_year / 10) % 10], GPoint(date_x_offset + 78, date_y_offset + 23), night_enabled);
-   set_bitmap_image(ctx, &date_image[7], DATENUM_IMAGE_RESOURCE_IDS[current_time->tm_year % 10], GPoint(date_x_offset + 91, date_y_offset + 23), night_enabled);
-   set_bitmap_image(ctx, &date_image[2], RESOURCE_ID_IMAGE_DATENUM_SLASH, GPoint(date_x_offset + 26, date_y_offset + 23), night_enabled);
-   set_bitmap_image(ctx, &date_image[5], RESOURCE_ID_IMAGE_DATENUM_SLASH, GPoint(date_x_offset + 65, date_y_offset + 23), night_enabled);
-}  // update_date()
+   draw_bitmap_image(ctx, splash_image, GPoint(LAYOUT_SPLASH_X, LAYOUT_SPLASH_Y), night_enabled);
+#endif
+}  // update_display()
 
 
-static void update_display(Layer *layer, GContext *ctx)
+static void update_images(const struct tm *current_time, BatteryChargeState batt_state)
 {
-   if (splash_timer == 0)
+   // the select_*_glyphs() functions pick resource IDs from their arguments alone,
+   // a block is only marked dirty when one of its glyphs has actually changed
+   if (update_time_images(current_time))
    {
-      if (freeze_timer == 0)
-      {
-         update_moves();
-      }
+      layer_mark_dirty(time_layer);
+   }
 
-      set_bitmap_image(ctx, &splash_image, RESOURCE_ID_IMAGE_WHITE_BACK, GPoint (0, 0), night_enabled);
-      update_date(layer, ctx);
-      update_time(layer, ctx);
+   if (update_date_images(current_time))
+   {
+      layer_mark_dirty(date_layer);
    }
-   else
+
+   if (update_batt_images(batt_state))
    {
-      set_bitmap_image(ctx, &splash_image, RESOURCE_ID_IMAGE_SPLASH, GPoint (0, 0), night_enabled);
+      layer_mark_dirty(batt_layer);
    }
-}  // update_display()
+}  // update_images()
+
+
+static void update_layers(void)
+{
+   if (freeze_timer > 0)
+   {
+      if (time_on_top)
+      {
+         time_x_offset = LAYOUT_FREEZE_X;
+         time_y_offset = LAYOUT_FREEZE_TOP_Y;
+
+         date_x_offset = LAYOUT_FREEZE_X;
+         date_y_offset = LAYOUT_FREEZE_BOTTOM_Y;
+      }
+      else
+      {
+         time_x_offset = LAYOUT_FREEZE_X;
+         time_y_offset = LAYOUT_FREEZE_BOTTOM_Y;
+
+         date_x_offset = LAYOUT_FREEZE_X;
+         date_y_offset = LAYOUT_FREEZE_TOP_Y;
+      }
+   }
+
+   // moving the frames lets the compositor handle motion without reloading any glyphs
+   layer_set_frame(time_layer, GRect(time_x_offset, time_y_offset, TIME_FIELD_WIDTH_12H, TIME_FIELD_HEIGHT));
+   layer_set_frame(date_layer, GRect(date_x_offset, date_y_offset, DATE_FIELD_WIDTH, DATE_FIELD_HEIGHT));
+   layer_set_frame(batt_layer, GRect(date_x_offset + BATT_FIELD_X, date_y_offset, BATT_FIELD_WIDTH, BATT_FIELD_HEIGHT));
+
+   layer_set_hidden(time_layer, splash_timer > 0);
+   layer_set_hidden(date_layer, splash_timer > 0);
+   layer_set_hidden(batt_layer, splash_timer > 0);
+}  // update_layers()
 
 
 static void update_moves(void)
@@ -540,15 +930,14 @@ static void update_moves(void)
    time_x_offset += time_x_delta;
    time_y_offset += time_y_delta;
 
-   // total date field is 104w x 39h
-   if ((date_x_offset + date_x_delta) < 0)
+   if ((date_x_offset + date_x_delta) < LAYOUT_MIN_X)
    {
       // generate a pseudo random number from 2, 4, & 6
       date_x_delta = ((rand() % 3) + 1) * 2;
    }
    else
    {
-      if ((date_x_offset + date_x_delta + date_x_max) >= 143)
+      if ((date_x_offset + date_x_delta + date_x_max) >= LAYOUT_MAX_X)
       {
          // generate a pseudo random number from -2, -4, & -6
          date_x_delta = ((rand() % 3) + 1) * 2;
@@ -556,15 +945,14 @@ static void update_moves(void)
       }
    }
 
-   // total time field is 103w x 52h for 12-hour clock & 93w x 52h for 24-hour clock
-   if ((time_x_offset + time_x_delta) < 0)
+   if ((time_x_offset + time_x_delta) < LAYOUT_MIN_X)
    {
       // generate a pseudo random number from 2, 4, & 6
       time_x_delta = ((rand() % 3) + 1) * 2;
    }
    else
    {
-      if ((time_x_offset + time_x_delta + time_x_max) >= 143)
+      if ((time_x_offset + time_x_delta + time_x_max) >= LAYOUT_MAX_X)
       {
          // generate a pseudo random number from -2, -4, & -6
          time_x_delta = ((rand() % 3) + 1) * 2;
@@ -574,20 +962,20 @@ static void update_moves(void)
 
    if (time_on_top == true)
    {
-      if ((time_y_offset + time_y_delta) < 0)
+      if ((time_y_offset + time_y_delta) < LAYOUT_MIN_Y)
       {
          // generate a pseudo random number from 3, 6, & 9
          time_y_delta = ((rand() % 3) + 1) * 3;
       }
 
-      if ((date_y_offset + date_y_delta + 39) >= 168)
+      if ((date_y_offset + date_y_delta + DATE_BOUNCE_HEIGHT) >= LAYOUT_MAX_Y)
       {
          // generate a pseudo random number from -4, -8, & -12
          date_y_delta = ((rand() % 3) + 1) * 4;
          date_y_delta = -date_y_delta;
       }
 
-      if (((date_y_offset + date_y_delta) - (time_y_offset + time_y_delta)) <= 52)
+      if (((date_y_offset + date_y_delta) - (time_y_offset + time_y_delta)) <= TIME_FIELD_HEIGHT)
       {
          // generate a pseudo random number from -3, -6, & -9
          time_y_delta = ((rand() % 3) + 1) * 3;
@@ -599,20 +987,20 @@ static void update_moves(void)
    }
    else
    {
-      if ((date_y_offset + date_y_delta) < 0)
+      if ((date_y_offset + date_y_delta) < LAYOUT_MIN_Y)
       {
          // generate a pseudo random number from 4, 8, & 12
          date_y_delta = ((rand() % 3) + 1) * 4;
       }
 
-      if ((time_y_offset + time_y_delta + 52) >= 168)
+      if ((time_y_offset + time_y_delta + TIME_FIELD_HEIGHT) >= LAYOUT_MAX_Y)
       {
          // generate a pseudo random number from -3, -6, & -9
          time_y_delta = ((rand() % 3) + 1) * 3;
          time_y_delta = -time_y_delta;
       }
 
-      if (((time_y_offset + time_y_delta) - (date_y_offset + date_y_delta)) <= 39)
+      if (((time_y_offset + time_y_delta) - (date_y_offset + date_y_delta)) <= DATE_BOUNCE_HEIGHT)
       {
          // generate a pseudo random number from 3, 6, & 9
          time_y_delta = ((rand() % 3) + 1) * 3;
@@ -627,66 +1015,30 @@ static void update_moves(void)
 
 static void update_time(Layer *layer, GContext *ctx)
 {
-   time_t t = time(NULL);
-   struct tm *current_time = localtime(&t);
-
-   if (freeze_timer > 0)
-   {
-      if (time_on_top)
-      {
-         time_x_offset = 20;
-         time_y_offset = 10;
-      }
-      else
-      {
-         time_x_offset = 20;
-         time_y_offset = 75;
-      }
-   }
+   // display time hour, colon, time minute & AM/PM
+   draw_bitmap_image(ctx, time_digits_image[0], GPoint(0, 0), night_enabled);
+   draw_bitmap_image(ctx, time_digits_image[1], GPoint(BIG_DIGIT_WIDTH, 0), night_enabled);
+   draw_bitmap_image(ctx, time_digits_image[2], GPoint(2 * BIG_DIGIT_WIDTH, 0), night_enabled);
+   draw_bitmap_image(ctx, time_digits_image[3], GPoint((2 * BIG_DIGIT_WIDTH) + COLON_WIDTH, 0), night_enabled);
+   draw_bitmap_image(ctx, time_digits_image[4], GPoint((3 * BIG_DIGIT_WIDTH) + COLON_WIDTH, 0), night_enabled);
+   draw_bitmap_image(ctx, time_digits_image[5], GPoint(TIME_FIELD_WIDTH_24H, 0), night_enabled);
+}  // update_time()
 
-   // display time hour
-   if (clock_24h_style)
-   {
-      set_bitmap_image(ctx, &time_digits_image[0], BIG_DIGIT_IMAGE_RESOURCE_IDS[current_time->tm_hour / 10], GPoint(time_x_offset, time_y_offset), night_enabled);
-      set_bitmap_image(ctx, &time_digits_image[1], BIG_DIGIT_IMAGE_RESOURCE_IDS[current_time->tm_hour % 10], GPoint(21 + time_x_offset, time_y_offset), night_enabled);
 
-      // display blank in place of AM/PM
-      set_bitmap_image(ctx, &time_digits_image[5], RESOURCE_ID_IMAGE_BLANK_MODE, GPoint(93 + time_x_offset, time_y_offset), night_enabled);
-   }
-   else
-   {
-      // display AM/PM
-      if (current_time->tm_hour >= 12)
-      {
-         set_bitmap_image(ctx, &time_digits_image[5], RESOURCE_ID_IMAGE_PM_MODE, GPoint(93 + time_x_offset, time_y_offset), night_enabled);
-      }
-      else
-      {
-         set_bitmap_image(ctx, &time_digits_image[5], RESOURCE_ID_IMAGE_AM_MODE, GPoint(93 + time_x_offset, time_y_offset), night_enabled);
-      }
+static bool update_time_images(const struct tm *current_time)
+{
+   int resource_ids[TOTAL_TIME_DIGITS];
+   bool changed = false;
 
-      if ((current_time->tm_hour % 12) == 0)
-      {
-         set_bitmap_image(ctx, &time_digits_image[0], BIG_DIGIT_IMAGE_RESOURCE_IDS[1], GPoint(time_x_offset, time_y_offset), night_enabled);
-         set_bitmap_image(ctx, &time_digits_image[1], BIG_DIGIT_IMAGE_RESOURCE_IDS[2], GPoint(21 + time_x_offset, time_y_offset), night_enabled);
-      }
-      else
-      {
-         set_bitmap_image(ctx, &time_digits_image[0], BIG_DIGIT_IMAGE_RESOURCE_IDS[(current_time->tm_hour % 12) / 10], GPoint(time_x_offset, time_y_offset), night_enabled);
-         set_bitmap_image(ctx, &time_digits_image[1], BIG_DIGIT_IMAGE_RESOURCE_IDS[(current_time->tm_hour % 12) % 10], GPoint(21 + time_x_offset, time_y_offset), night_enabled);
+   select_time_glyphs(current_time, clock_24h_style, resource_ids);
 
-         if ((current_time->tm_hour % 12) < 10)
-         {
-            set_bitmap_image(ctx, &time_digits_image[0], RESOURCE_ID_IMAGE_NUM_BLANK, GPoint(time_x_offset, time_y_offset), night_enabled);
-         }
-      }
+   for (int i = 0; i < TOTAL_TIME_DIGITS; i++)
+   {
+      changed |= load_bitmap_image(&time_digits_image[i], &time_digits_resource_id[i], resource_ids[i], night_enabled);
    }
 
-   // display colon & time minute
-   set_bitmap_image(ctx, &time_digits_image[2], RESOURCE_ID_IMAGE_COLON, GPoint(42 + time_x_offset, time_y_offset), night_enabled);
-   set_bitmap_image(ctx, &time_digits_image[3], BIG_DIGIT_IMAGE_RESOURCE_IDS[current_time->tm_min / 10], GPoint(51 + time_x_offset, time_y_offset), night_enabled);
-   set_bitmap_image(ctx, &time_digits_image[4], BIG_DIGIT_IMAGE_RESOURCE_IDS[current_time->tm_min % 10], GPoint(72 + time_x_offset, time_y_offset), night_enabled);
-}  // update_time()
+   return changed;
+}  // update_time_images()
 
 
 int main(void) {
@@ -0,0 +1,223 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/* *                                                                 * */
+/* *     Host stand-in for the Pebble SDK 3 API used by Ricochet2    * */
+/* *                                                                 * */
+/* *   Just enough of <pebble.h> to run the watchface on a desktop:  * */
+/* *   a 144x168 framebuffer (1-bit, or 8-bit with PBL_COLOR), a     * */
+/* *   layer tree, PNG resources & bitmap allocation counters        * */
+/* *   (see pebble_stub.c)                                           * */
+/* *                                                                 * */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PEBBLE_STUB_H
+#define PEBBLE_STUB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define STUB_SCREEN_WIDTH 144
+#define STUB_SCREEN_HEIGHT 168
+
+typedef struct
+{
+   int16_t x;
+   int16_t y;
+} GPoint;
+
+typedef struct
+{
+   int16_t w;
+   int16_t h;
+} GSize;
+
+typedef struct
+{
+   GPoint origin;
+   GSize size;
+} GRect;
+
+#define GPoint(x, y) ((GPoint){ (x), (y) })
+#define GRect(x, y, w, h) ((GRect){ { (x), (y) }, { (w), (h) } })
+
+typedef union
+{
+   uint8_t argb;
+} GColor;
+
+#define GColorBlack ((GColor){ .argb = 0xC0 })
+#define GColorWhite ((GColor){ .argb = 0xFF })
+
+typedef enum
+{
+   GCompOpAssign,
+   GCompOpAssignInverted,
+} GCompOp;
+
+typedef enum
+{
+   GBitmapFormat1Bit,
+   GBitmapFormat8Bit,
+   GBitmapFormat1BitPalette,
+   GBitmapFormat2BitPalette,
+   GBitmapFormat4BitPalette,
+} GBitmapFormat;
+
+typedef enum
+{
+   GCornerNone = 0,
+} GCornerMask;
+
+typedef struct GBitmap GBitmap;
+typedef struct GContext GContext;
+typedef struct Layer Layer;
+typedef struct Window Window;
+
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+
+typedef struct
+{
+   uint8_t charge_percent;
+   bool is_charging;
+   bool is_plugged;
+} BatteryChargeState;
+
+typedef enum
+{
+   BUTTON_ID_BACK,
+   BUTTON_ID_UP,
+   BUTTON_ID_SELECT,
+   BUTTON_ID_DOWN,
+} ButtonId;
+
+typedef void *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+
+typedef enum
+{
+   ACCEL_AXIS_X,
+   ACCEL_AXIS_Y,
+   ACCEL_AXIS_Z,
+} AccelAxisType;
+
+typedef enum
+{
+   SECOND_UNIT = 1 << 0,
+   MINUTE_UNIT = 1 << 1,
+   HOUR_UNIT = 1 << 2,
+   DAY_UNIT = 1 << 3,
+   MONTH_UNIT = 1 << 4,
+   YEAR_UNIT = 1 << 5,
+} TimeUnits;
+
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+typedef void (*AccelTapHandler)(AccelAxisType axis, int32_t direction);
+
+typedef enum
+{
+   APP_LOG_LEVEL_ERROR = 1,
+   APP_LOG_LEVEL_WARNING = 50,
+   APP_LOG_LEVEL_INFO = 100,
+   APP_LOG_LEVEL_DEBUG = 200,
+} AppLogLevel;
+
+#define APP_LOG(level, ...) ((void)(level))
+
+// Resource IDs, in the same order as the media list in appinfo.json
+enum
+{
+   RESOURCE_ID_INVALID = 0,
+   RESOURCE_ID_IMAGE_MENU_ICON,
+   RESOURCE_ID_IMAGE_WHITE_BACK,
+   RESOURCE_ID_IMAGE_SPLASH,
+   RESOURCE_ID_IMAGE_COLON,
+   RESOURCE_ID_IMAGE_AM_MODE,
+   RESOURCE_ID_IMAGE_PM_MODE,
+   RESOURCE_ID_IMAGE_BLANK_MODE,
+   RESOURCE_ID_IMAGE_NUM_0,
+   RESOURCE_ID_IMAGE_NUM_1,
+   RESOURCE_ID_IMAGE_NUM_2,
+   RESOURCE_ID_IMAGE_NUM_3,
+   RESOURCE_ID_IMAGE_NUM_4,
+   RESOURCE_ID_IMAGE_NUM_5,
+   RESOURCE_ID_IMAGE_NUM_6,
+   RESOURCE_ID_IMAGE_NUM_7,
+   RESOURCE_ID_IMAGE_NUM_8,
+   RESOURCE_ID_IMAGE_NUM_9,
+   RESOURCE_ID_IMAGE_NUM_BLANK,
+   RESOURCE_ID_IMAGE_DATENUM_0,
+   RESOURCE_ID_IMAGE_DATENUM_1,
+   RESOURCE_ID_IMAGE_DATENUM_2,
+   RESOURCE_ID_IMAGE_DATENUM_3,
+   RESOURCE_ID_IMAGE_DATENUM_4,
+   RESOURCE_ID_IMAGE_DATENUM_5,
+   RESOURCE_ID_IMAGE_DATENUM_6,
+   RESOURCE_ID_IMAGE_DATENUM_7,
+   RESOURCE_ID_IMAGE_DATENUM_8,
+   RESOURCE_ID_IMAGE_DATENUM_9,
+   RESOURCE_ID_IMAGE_DATENUM_SLASH,
+   RESOURCE_ID_IMAGE_DATENUM_BLANK,
+   RESOURCE_ID_IMAGE_DATENUM_PERCENT,
+   RESOURCE_ID_IMAGE_DATENUM_PLUS,
+   RESOURCE_ID_IMAGE_DAY_SUN,
+   RESOURCE_ID_IMAGE_DAY_MON,
+   RESOURCE_ID_IMAGE_DAY_TUE,
+   RESOURCE_ID_IMAGE_DAY_WED,
+   RESOURCE_ID_IMAGE_DAY_THU,
+   RESOURCE_ID_IMAGE_DAY_FRI,
+   RESOURCE_ID_IMAGE_DAY_SAT,
+   STUB_RESOURCE_COUNT
+};
+
+
+// Pebble SDK API subset
+void accel_tap_service_subscribe(AccelTapHandler handler);
+void accel_tap_service_unsubscribe(void);
+void app_event_loop(void);
+BatteryChargeState battery_state_service_peek(void);
+bool clock_is_24h_style(void);
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id);
+void gbitmap_destroy(GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+GColor *gbitmap_get_palette(const GBitmap *bitmap);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void layer_add_child(Layer *parent, Layer *child);
+Layer *layer_create(GRect frame);
+void layer_destroy(Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_frame(const Layer *layer);
+void layer_mark_dirty(Layer *layer);
+void layer_remove_from_parent(Layer *child);
+void layer_set_frame(Layer *layer, GRect frame);
+void layer_set_hidden(Layer *layer, bool hidden);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void light_enable(bool enable);
+bool persist_exists(const uint32_t key);
+int32_t persist_read_int(const uint32_t key);
+int persist_write_int(const uint32_t key, const int32_t value);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+void window_destroy(Window *window);
+Layer *window_get_root_layer(const Window *window);
+Window *window_create(void);
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler, ClickHandler up_handler);
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider);
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+void window_stack_push(Window *window, bool animated);
+
+
+// Host-only hooks for the test suite
+extern BatteryChargeState stub_battery_state;
+extern int stub_bitmaps_created;
+extern int stub_bitmaps_destroyed;
+
+const GColor *stub_framebuffer(void);
+void stub_render_window(Window *window);
+
+#endif
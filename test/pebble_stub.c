@@ -0,0 +1,663 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/* *                                                                 * */
+/* *     Host stand-in for the Pebble SDK 3 API used by Ricochet2    * */
+/* *                                                                 * */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#include <pebble.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+#define MAX_CHILD_LAYERS 8
+
+struct GBitmap
+{
+   GRect bounds;
+   GBitmapFormat format;
+   GColor palette[2];      // palettized formats only
+   uint8_t *pixels;        // one byte per pixel: palette index, or 1 = white, 0 = black for GBitmapFormat1Bit
+};
+
+struct GContext
+{
+   GCompOp compositing_mode;
+   GColor fill_color;
+   GPoint offset;          // screen position of the layer being drawn
+   GRect clip;             // screen area the layer being drawn may touch
+};
+
+struct Layer
+{
+   GRect frame;
+   bool hidden;
+   LayerUpdateProc update_proc;
+   Layer *parent;
+   Layer *children[MAX_CHILD_LAYERS];
+   int child_count;
+};
+
+struct Window
+{
+   Layer *root_layer;
+};
+
+BatteryChargeState stub_battery_state = { 100, false, false };
+int stub_bitmaps_created = 0;
+int stub_bitmaps_destroyed = 0;
+
+static GColor framebuffer[STUB_SCREEN_WIDTH * STUB_SCREEN_HEIGHT];
+
+// Resource file names, indexed by the RESOURCE_ID_* values in pebble.h
+static const char *RESOURCE_FILES[STUB_RESOURCE_COUNT] =
+{
+   [RESOURCE_ID_IMAGE_MENU_ICON] = "menu_icon_Ricochet2.png",
+   [RESOURCE_ID_IMAGE_WHITE_BACK] = "white.png",
+   [RESOURCE_ID_IMAGE_SPLASH] = "splash.png",
+   [RESOURCE_ID_IMAGE_COLON] = "char_colon.png",
+   [RESOURCE_ID_IMAGE_AM_MODE] = "time_format_AM.png",
+   [RESOURCE_ID_IMAGE_PM_MODE] = "time_format_PM.png",
+   [RESOURCE_ID_IMAGE_BLANK_MODE] = "time_format_blank.png",
+   [RESOURCE_ID_IMAGE_NUM_0] = "num_0.png",
+   [RESOURCE_ID_IMAGE_NUM_1] = "num_1.png",
+   [RESOURCE_ID_IMAGE_NUM_2] = "num_2.png",
+   [RESOURCE_ID_IMAGE_NUM_3] = "num_3.png",
+   [RESOURCE_ID_IMAGE_NUM_4] = "num_4.png",
+   [RESOURCE_ID_IMAGE_NUM_5] = "num_5.png",
+   [RESOURCE_ID_IMAGE_NUM_6] = "num_6.png",
+   [RESOURCE_ID_IMAGE_NUM_7] = "num_7.png",
+   [RESOURCE_ID_IMAGE_NUM_8] = "num_8.png",
+   [RESOURCE_ID_IMAGE_NUM_9] = "num_9.png",
+   [RESOURCE_ID_IMAGE_NUM_BLANK] = "num_blank.png",
+   [RESOURCE_ID_IMAGE_DATENUM_0] = "datenum_0.png",
+   [RESOURCE_ID_IMAGE_DATENUM_1] = "datenum_1.png",
+   [RESOURCE_ID_IMAGE_DATENUM_2] = "datenum_2.png",
+   [RESOURCE_ID_IMAGE_DATENUM_3] = "datenum_3.png",
+   [RESOURCE_ID_IMAGE_DATENUM_4] = "datenum_4.png",
+   [RESOURCE_ID_IMAGE_DATENUM_5] = "datenum_5.png",
+   [RESOURCE_ID_IMAGE_DATENUM_6] = "datenum_6.png",
+   [RESOURCE_ID_IMAGE_DATENUM_7] = "datenum_7.png",
+   [RESOURCE_ID_IMAGE_DATENUM_8] = "datenum_8.png",
+   [RESOURCE_ID_IMAGE_DATENUM_9] = "datenum_9.png",
+   [RESOURCE_ID_IMAGE_DATENUM_SLASH] = "datenum_slash.png",
+   [RESOURCE_ID_IMAGE_DATENUM_BLANK] = "datenum_blank.png",
+   [RESOURCE_ID_IMAGE_DATENUM_PERCENT] = "datenum_percent.png",
+   [RESOURCE_ID_IMAGE_DATENUM_PLUS] = "datenum_plus.png",
+   [RESOURCE_ID_IMAGE_DAY_SUN] = "day_sun.png",
+   [RESOURCE_ID_IMAGE_DAY_MON] = "day_mon.png",
+   [RESOURCE_ID_IMAGE_DAY_TUE] = "day_tue.png",
+   [RESOURCE_ID_IMAGE_DAY_WED] = "day_wed.png",
+   [RESOURCE_ID_IMAGE_DAY_THU] = "day_thu.png",
+   [RESOURCE_ID_IMAGE_DAY_FRI] = "day_fri.png",
+   [RESOURCE_ID_IMAGE_DAY_SAT] = "day_sat.png",
+};
+
+
+static void fail(const char *what, const char *detail);
+static uint32_t read_be32(const uint8_t *bytes);
+static void render_layer(Layer *layer, GPoint parent_offset, GRect parent_clip);
+static int paeth(int a, int b, int c);
+static GBitmap *png_decode(const char *path);
+static GRect rect_intersect(GRect a, GRect b);
+
+
+
+static void fail(const char *what, const char *detail)
+{
+   fprintf(stderr, "pebble_stub: %s: %s\n", what, detail);
+   exit(2);
+}  // fail()
+
+
+static uint32_t read_be32(const uint8_t *bytes)
+{
+   return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}  // read_be32()
+
+
+static int paeth(int a, int b, int c)
+{
+   int p = a + b - c;
+   int pa = abs(p - a);
+   int pb = abs(p - b);
+   int pc = abs(p - c);
+
+   if ((pa <= pb) && (pa <= pc))
+   {
+      return a;
+   }
+
+   if (pb <= pc)
+   {
+      return b;
+   }
+
+   return c;
+}  // paeth()
+
+
+// Decodes the 1-bit palettized or grayscale PNGs used by the watchface, the way the SDK loads them:
+// GBitmapFormat1Bit on a 1-bit display, GBitmapFormat1BitPalette on a color one (unless the suite
+// is built with STUB_1BIT_BITMAPS, to exercise the color code path for bitmaps without a palette)
+static GBitmap *png_decode(const char *path)
+{
+   static const uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+   FILE *file = fopen(path, "rb");
+   if (file == NULL)
+   {
+      fail("can't open resource", path);
+   }
+
+   fseek(file, 0, SEEK_END);
+   long file_size = ftell(file);
+   fseek(file, 0, SEEK_SET);
+
+   uint8_t *data = malloc(file_size);
+   if (fread(data, 1, file_size, file) != (size_t)file_size)
+   {
+      fail("can't read resource", path);
+   }
+   fclose(file);
+
+   if ((file_size < 8) || (memcmp(data, PNG_SIGNATURE, 8) != 0))
+   {
+      fail("not a PNG", path);
+   }
+
+   uint32_t width = 0;
+   uint32_t height = 0;
+   uint8_t color_type = 0;
+   uint8_t palette_white[2] = { 0, 1 };
+   GColor palette[2] = { GColorBlack, GColorWhite };
+   uint8_t *idat = NULL;
+   size_t idat_size = 0;
+
+   for (long pos = 8; pos + 12 <= file_size; )
+   {
+      uint32_t length = read_be32(&data[pos]);
+      const uint8_t *type = &data[pos + 4];
+      const uint8_t *body = &data[pos + 8];
+
+      if (memcmp(type, "IHDR", 4) == 0)
+      {
+         width = read_be32(&body[0]);
+         height = read_be32(&body[4]);
+         color_type = body[9];
+
+         if ((body[8] != 1) || ((color_type != 0) && (color_type != 3)) || (body[12] != 0))
+         {
+            fail("unsupported PNG format (expected 1-bit, non-interlaced)", path);
+         }
+      }
+      else if (memcmp(type, "PLTE", 4) == 0)
+      {
+         for (uint32_t i = 0; (i < 2) && (i * 3 + 2 < length); i++)
+         {
+            palette_white[i] = ((body[i * 3] + body[i * 3 + 1] + body[i * 3 + 2]) >= (3 * 128));
+
+            // opaque, 2 bits per channel
+            palette[i].argb = 0xC0 | ((body[i * 3] >> 6) << 4) | ((body[i * 3 + 1] >> 6) << 2) | (body[i * 3 + 2] >> 6);
+         }
+      }
+      else if (memcmp(type, "IDAT", 4) == 0)
+      {
+         idat = realloc(idat, idat_size + length);
+         memcpy(&idat[idat_size], body, length);
+         idat_size += length;
+      }
+      else if (memcmp(type, "IEND", 4) == 0)
+      {
+         break;
+      }
+
+      pos += 12 + length;
+   }
+
+   uint32_t stride = (width + 7) / 8;
+   uLongf raw_size = (stride + 1) * height;
+   uint8_t *raw = malloc(raw_size);
+
+   if ((idat == NULL) || (uncompress(raw, &raw_size, idat, idat_size) != Z_OK) || (raw_size != (stride + 1) * height))
+   {
+      fail("corrupt PNG image data", path);
+   }
+
+   // undo the per-row filters in place (one byte per "pixel" at 1-bit depth)
+   for (uint32_t y = 0; y < height; y++)
+   {
+      uint8_t filter = raw[y * (stride + 1)];
+      uint8_t *row = &raw[y * (stride + 1) + 1];
+      const uint8_t *prior = (y > 0) ? &raw[(y - 1) * (stride + 1) + 1] : NULL;
+
+      for (uint32_t x = 0; x < stride; x++)
+      {
+         int a = (x > 0) ? row[x - 1] : 0;
+         int b = (prior != NULL) ? prior[x] : 0;
+         int c = ((x > 0) && (prior != NULL)) ? prior[x - 1] : 0;
+
+         switch (filter)
+         {
+            case 0:
+               break;
+            case 1:
+               row[x] += a;
+               break;
+            case 2:
+               row[x] += b;
+               break;
+            case 3:
+               row[x] += (a + b) / 2;
+               break;
+            case 4:
+               row[x] += paeth(a, b, c);
+               break;
+            default:
+               fail("bad PNG row filter", path);
+         }
+      }
+   }
+
+   GBitmap *bitmap = malloc(sizeof(GBitmap));
+   bitmap->bounds = GRect(0, 0, width, height);
+#if defined(PBL_COLOR) && !defined(STUB_1BIT_BITMAPS)
+   bitmap->format = GBitmapFormat1BitPalette;
+#else
+   bitmap->format = GBitmapFormat1Bit;
+#endif
+   memcpy(bitmap->palette, palette, sizeof(bitmap->palette));
+   bitmap->pixels = malloc(width * height);
+
+   for (uint32_t y = 0; y < height; y++)
+   {
+      const uint8_t *row = &raw[y * (stride + 1) + 1];
+
+      for (uint32_t x = 0; x < width; x++)
+      {
+         int bit = (row[x / 8] >> (7 - (x % 8))) & 1;
+
+         if (bitmap->format == GBitmapFormat1Bit)
+         {
+            bitmap->pixels[y * width + x] = (color_type == 3) ? palette_white[bit] : bit;
+         }
+         else
+         {
+            bitmap->pixels[y * width + x] = bit;
+         }
+      }
+   }
+
+   free(raw);
+   free(idat);
+   free(data);
+
+   return bitmap;
+}  // png_decode()
+
+
+static GRect rect_intersect(GRect a, GRect b)
+{
+   int x0 = (a.origin.x > b.origin.x) ? a.origin.x : b.origin.x;
+   int y0 = (a.origin.y > b.origin.y) ? a.origin.y : b.origin.y;
+   int x1 = ((a.origin.x + a.size.w) < (b.origin.x + b.size.w)) ? (a.origin.x + a.size.w) : (b.origin.x + b.size.w);
+   int y1 = ((a.origin.y + a.size.h) < (b.origin.y + b.size.h)) ? (a.origin.y + a.size.h) : (b.origin.y + b.size.h);
+
+   if ((x1 <= x0) || (y1 <= y0))
+   {
+      return GRect(x0, y0, 0, 0);
+   }
+
+   return GRect(x0, y0, x1 - x0, y1 - y0);
+}  // rect_intersect()
+
+
+static void render_layer(Layer *layer, GPoint parent_offset, GRect parent_clip)
+{
+   if (layer->hidden)
+   {
+      return;
+   }
+
+   GPoint offset = GPoint(parent_offset.x + layer->frame.origin.x, parent_offset.y + layer->frame.origin.y);
+   GRect clip = rect_intersect(parent_clip, GRect(offset.x, offset.y, layer->frame.size.w, layer->frame.size.h));
+
+   if (layer->update_proc != NULL)
+   {
+      GContext ctx = { GCompOpAssign, GColorBlack, offset, clip };
+
+      layer->update_proc(layer, &ctx);
+   }
+
+   for (int i = 0; i < layer->child_count; i++)
+   {
+      render_layer(layer->children[i], offset, clip);
+   }
+}  // render_layer()
+
+
+
+void accel_tap_service_subscribe(AccelTapHandler handler)
+{
+}  // accel_tap_service_subscribe()
+
+
+void accel_tap_service_unsubscribe(void)
+{
+}  // accel_tap_service_unsubscribe()
+
+
+void app_event_loop(void)
+{
+}  // app_event_loop()
+
+
+BatteryChargeState battery_state_service_peek(void)
+{
+   return stub_battery_state;
+}  // battery_state_service_peek()
+
+
+bool clock_is_24h_style(void)
+{
+   return false;
+}  // clock_is_24h_style()
+
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id)
+{
+   char path[512];
+
+   if ((resource_id == RESOURCE_ID_INVALID) || (resource_id >= STUB_RESOURCE_COUNT))
+   {
+      fail("bad resource id", "gbitmap_create_with_resource()");
+   }
+
+   snprintf(path, sizeof(path), "%s/%s", RESOURCE_DIR, RESOURCE_FILES[resource_id]);
+
+   stub_bitmaps_created++;
+
+   return png_decode(path);
+}  // gbitmap_create_with_resource()
+
+
+void gbitmap_destroy(GBitmap *bitmap)
+{
+   if (bitmap != NULL)
+   {
+      stub_bitmaps_destroyed++;
+
+      free(bitmap->pixels);
+      free(bitmap);
+   }
+}  // gbitmap_destroy()
+
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap)
+{
+   return bitmap->bounds;
+}  // gbitmap_get_bounds()
+
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap)
+{
+   return bitmap->format;
+}  // gbitmap_get_format()
+
+
+GColor *gbitmap_get_palette(const GBitmap *bitmap)
+{
+   if (bitmap->format == GBitmapFormat1Bit)
+   {
+      return NULL;
+   }
+
+   return (GColor *)bitmap->palette;
+}  // gbitmap_get_palette()
+
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode)
+{
+   ctx->compositing_mode = mode;
+}  // graphics_context_set_compositing_mode()
+
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color)
+{
+   ctx->fill_color = color;
+}  // graphics_context_set_fill_color()
+
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect)
+{
+   GRect target = rect_intersect(ctx->clip, GRect(ctx->offset.x + rect.origin.x, ctx->offset.y + rect.origin.y, rect.size.w, rect.size.h));
+   int width = bitmap->bounds.size.w;
+   int height = bitmap->bounds.size.h;
+
+   target = rect_intersect(target, GRect(0, 0, STUB_SCREEN_WIDTH, STUB_SCREEN_HEIGHT));
+
+   for (int y = target.origin.y; y < target.origin.y + target.size.h; y++)
+   {
+      // the bitmap is tiled when the rect is larger than the image
+      int src_y = (y - (ctx->offset.y + rect.origin.y)) % height;
+
+      for (int x = target.origin.x; x < target.origin.x + target.size.w; x++)
+      {
+         int src_x = (x - (ctx->offset.x + rect.origin.x)) % width;
+         uint8_t pixel = bitmap->pixels[src_y * width + src_x];
+
+         if (bitmap->format == GBitmapFormat1Bit)
+         {
+            if (ctx->compositing_mode == GCompOpAssignInverted)
+            {
+               pixel = !pixel;
+            }
+
+            framebuffer[y * STUB_SCREEN_WIDTH + x] = pixel ? GColorWhite : GColorBlack;
+         }
+         else
+         {
+            // like the SDK, compositing modes other than GCompOpAssign only apply to 1-bit bitmaps
+            framebuffer[y * STUB_SCREEN_WIDTH + x] = bitmap->palette[pixel];
+         }
+      }
+   }
+}  // graphics_draw_bitmap_in_rect()
+
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask)
+{
+   GRect target = rect_intersect(ctx->clip, GRect(ctx->offset.x + rect.origin.x, ctx->offset.y + rect.origin.y, rect.size.w, rect.size.h));
+
+   target = rect_intersect(target, GRect(0, 0, STUB_SCREEN_WIDTH, STUB_SCREEN_HEIGHT));
+
+   for (int y = target.origin.y; y < target.origin.y + target.size.h; y++)
+   {
+      for (int x = target.origin.x; x < target.origin.x + target.size.w; x++)
+      {
+         framebuffer[y * STUB_SCREEN_WIDTH + x] = ctx->fill_color;
+      }
+   }
+}  // graphics_fill_rect()
+
+
+void layer_add_child(Layer *parent, Layer *child)
+{
+   if (parent->child_count == MAX_CHILD_LAYERS)
+   {
+      fail("too many child layers", "layer_add_child()");
+   }
+
+   parent->children[parent->child_count++] = child;
+   child->parent = parent;
+}  // layer_add_child()
+
+
+Layer *layer_create(GRect frame)
+{
+   Layer *layer = calloc(1, sizeof(Layer));
+
+   layer->frame = frame;
+
+   return layer;
+}  // layer_create()
+
+
+void layer_destroy(Layer *layer)
+{
+   layer_remove_from_parent(layer);
+   free(layer);
+}  // layer_destroy()
+
+
+GRect layer_get_bounds(const Layer *layer)
+{
+   return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}  // layer_get_bounds()
+
+
+GRect layer_get_frame(const Layer *layer)
+{
+   return layer->frame;
+}  // layer_get_frame()
+
+
+void layer_mark_dirty(Layer *layer)
+{
+}  // layer_mark_dirty()
+
+
+void layer_remove_from_parent(Layer *child)
+{
+   Layer *parent = child->parent;
+
+   if (parent == NULL)
+   {
+      return;
+   }
+
+   for (int i = 0; i < parent->child_count; i++)
+   {
+      if (parent->children[i] == child)
+      {
+         memmove(&parent->children[i], &parent->children[i + 1], (parent->child_count - i - 1) * sizeof(Layer *));
+         parent->child_count--;
+         break;
+      }
+   }
+
+   child->parent = NULL;
+}  // layer_remove_from_parent()
+
+
+void layer_set_frame(Layer *layer, GRect frame)
+{
+   layer->frame = frame;
+}  // layer_set_frame()
+
+
+void layer_set_hidden(Layer *layer, bool hidden)
+{
+   layer->hidden = hidden;
+}  // layer_set_hidden()
+
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc)
+{
+   layer->update_proc = update_proc;
+}  // layer_set_update_proc()
+
+
+void light_enable(bool enable)
+{
+}  // light_enable()
+
+
+bool persist_exists(const uint32_t key)
+{
+   return false;
+}  // persist_exists()
+
+
+int32_t persist_read_int(const uint32_t key)
+{
+   return 0;
+}  // persist_read_int()
+
+
+int persist_write_int(const uint32_t key, const int32_t value)
+{
+   return sizeof(int32_t);
+}  // persist_write_int()
+
+
+const GColor *stub_framebuffer(void)
+{
+   return framebuffer;
+}  // stub_framebuffer()
+
+
+void stub_render_window(Window *window)
+{
+   // the window background is white until the root layer draws over it
+   for (int i = 0; i < STUB_SCREEN_WIDTH * STUB_SCREEN_HEIGHT; i++)
+   {
+      framebuffer[i] = GColorWhite;
+   }
+
+   render_layer(window->root_layer, GPoint(0, 0), GRect(0, 0, STUB_SCREEN_WIDTH, STUB_SCREEN_HEIGHT));
+}  // stub_render_window()
+
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler)
+{
+}  // tick_timer_service_subscribe()
+
+
+void tick_timer_service_unsubscribe(void)
+{
+}  // tick_timer_service_unsubscribe()
+
+
+Window *window_create(void)
+{
+   Window *window = calloc(1, sizeof(Window));
+
+   window->root_layer = layer_create(GRect(0, 0, STUB_SCREEN_WIDTH, STUB_SCREEN_HEIGHT));
+
+   return window;
+}  // window_create()
+
+
+void window_destroy(Window *window)
+{
+   layer_destroy(window->root_layer);
+   free(window);
+}  // window_destroy()
+
+
+Layer *window_get_root_layer(const Window *window)
+{
+   return window->root_layer;
+}  // window_get_root_layer()
+
+
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler, ClickHandler up_handler)
+{
+}  // window_long_click_subscribe()
+
+
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider)
+{
+}  // window_set_click_config_provider()
+
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler)
+{
+}  // window_single_click_subscribe()
+
+
+void window_stack_push(Window *window, bool animated)
+{
+}  // window_stack_push()
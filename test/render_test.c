@@ -0,0 +1,603 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/* *                                                                 * */
+/* *         Ricochet2 render correctness & performance suite        * */
+/* *                                                                 * */
+/* *   Renders the watchface on the host for a matrix of times,      * */
+/* *   battery states & mode flags, compares every frame against a   * */
+/* *   golden black & white frame & checks the bitmap loads per      * */
+/* *   frame against a stored baseline (build & run with "make       * */
+/* *   check" in this directory)                                     * */
+/* *                                                                 * */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Pull in the watchface itself, so the suite can drive its state & static functions directly
+#define main ricochet2_main
+#include "../src/Ricochet2.c"
+#undef main
+
+#define FRAME_BYTES ((STUB_SCREEN_WIDTH / 8) * STUB_SCREEN_HEIGHT)
+#define TICK_REPEATS 20
+#define MOVED_TICKS 3
+
+// a move-only tick must take at most this fraction of a tick that reloads every glyph (same run)
+#define TICK_TIME_RATIO_MAX 0.75
+
+typedef struct
+{
+   const char *name;
+   BatteryChargeState state;
+} TestBattery;
+
+typedef struct
+{
+   long frame_allocs;
+   long tick_allocs;
+   long full_allocs;
+} Baseline;
+
+static const int TEST_HOURS[] = { 0, 9, 12, 23 };
+
+static const TestBattery TEST_BATTERIES[] =
+{
+   { "charging", { 50, true, true } },
+   { "full", { 100, false, true } },
+   { "low", { 5, false, false } },
+};
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                         \
+   do                                                            \
+   {                                                             \
+      if (!(cond))                                               \
+      {                                                          \
+         fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__);    \
+         fprintf(stderr, __VA_ARGS__);                           \
+         fprintf(stderr, "\n");                                  \
+         failures++;                                             \
+      }                                                          \
+   } while (0)
+
+
+static int check_glyph_selection(void);
+static void check_moved_frame(bool update_golden);
+static bool compare_golden(const char *name, bool update);
+static bool equal_rects(GRect a, GRect b);
+static void invalidate_glyph_cache(void);
+static bool load_baseline(const char *path, Baseline *baseline);
+static double now_us(void);
+static void pack_frame(uint8_t packed[FRAME_BYTES]);
+static void render_frame(const struct tm *current_time, BatteryChargeState batt_state);
+static void set_night(bool night);
+static struct tm test_time(int hour);
+static bool write_baseline(const char *path, const Baseline *measured);
+
+
+
+static int check_glyph_selection(void)
+{
+   static const int EXPECTED_12H[][TOTAL_TIME_DIGITS] =
+   {
+      { RESOURCE_ID_IMAGE_NUM_1, RESOURCE_ID_IMAGE_NUM_2, RESOURCE_ID_IMAGE_COLON, RESOURCE_ID_IMAGE_NUM_4, RESOURCE_ID_IMAGE_NUM_5, RESOURCE_ID_IMAGE_AM_MODE },
+      { RESOURCE_ID_IMAGE_NUM_BLANK, RESOURCE_ID_IMAGE_NUM_9, RESOURCE_ID_IMAGE_COLON, RESOURCE_ID_IMAGE_NUM_4, RESOURCE_ID_IMAGE_NUM_5, RESOURCE_ID_IMAGE_AM_MODE },
+      { RESOURCE_ID_IMAGE_NUM_1, RESOURCE_ID_IMAGE_NUM_2, RESOURCE_ID_IMAGE_COLON, RESOURCE_ID_IMAGE_NUM_4, RESOURCE_ID_IMAGE_NUM_5, RESOURCE_ID_IMAGE_PM_MODE },
+      { RESOURCE_ID_IMAGE_NUM_1, RESOURCE_ID_IMAGE_NUM_1, RESOURCE_ID_IMAGE_COLON, RESOURCE_ID_IMAGE_NUM_4, RESOURCE_ID_IMAGE_NUM_5, RESOURCE_ID_IMAGE_PM_MODE },
+   };
+   static const int EXPECTED_24H[][TOTAL_TIME_DIGITS] =
+   {
+      { RESOURCE_ID_IMAGE_NUM_0, RESOURCE_ID_IMAGE_NUM_0, RESOURCE_ID_IMAGE_COLON, RESOURCE_ID_IMAGE_NUM_4, RESOURCE_ID_IMAGE_NUM_5, RESOURCE_ID_IMAGE_BLANK_MODE },
+      { RESOURCE_ID_IMAGE_NUM_0, RESOURCE_ID_IMAGE_NUM_9, RESOURCE_ID_IMAGE_COLON, RESOURCE_ID_IMAGE_NUM_4, RESOURCE_ID_IMAGE_NUM_5, RESOURCE_ID_IMAGE_BLANK_MODE },
+      { RESOURCE_ID_IMAGE_NUM_1, RESOURCE_ID_IMAGE_NUM_2, RESOURCE_ID_IMAGE_COLON, RESOURCE_ID_IMAGE_NUM_4, RESOURCE_ID_IMAGE_NUM_5, RESOURCE_ID_IMAGE_BLANK_MODE },
+      { RESOURCE_ID_IMAGE_NUM_2, RESOURCE_ID_IMAGE_NUM_3, RESOURCE_ID_IMAGE_COLON, RESOURCE_ID_IMAGE_NUM_4, RESOURCE_ID_IMAGE_NUM_5, RESOURCE_ID_IMAGE_BLANK_MODE },
+   };
+   static const int EXPECTED_BATT[][TOTAL_BATT_DIGITS] =
+   {
+      { RESOURCE_ID_IMAGE_DATENUM_PLUS, RESOURCE_ID_IMAGE_DATENUM_5, RESOURCE_ID_IMAGE_DATENUM_0, RESOURCE_ID_IMAGE_DATENUM_PERCENT },
+      // 100% wraps to 0 before the tens digit is picked, so it has always shown as "1 0%"
+      { RESOURCE_ID_IMAGE_DATENUM_1, RESOURCE_ID_IMAGE_DATENUM_BLANK, RESOURCE_ID_IMAGE_DATENUM_0, RESOURCE_ID_IMAGE_DATENUM_PERCENT },
+      { RESOURCE_ID_IMAGE_DATENUM_BLANK, RESOURCE_ID_IMAGE_DATENUM_BLANK, RESOURCE_ID_IMAGE_DATENUM_5, RESOURCE_ID_IMAGE_DATENUM_PERCENT },
+   };
+   static const int EXPECTED_DATE[TOTAL_DATE_DIGITS] =
+   {
+      RESOURCE_ID_IMAGE_DATENUM_0, RESOURCE_ID_IMAGE_DATENUM_3, RESOURCE_ID_IMAGE_DATENUM_SLASH,
+      RESOURCE_ID_IMAGE_DATENUM_2, RESOURCE_ID_IMAGE_DATENUM_7, RESOURCE_ID_IMAGE_DATENUM_SLASH,
+      RESOURCE_ID_IMAGE_DATENUM_1, RESOURCE_ID_IMAGE_DATENUM_5,
+   };
+
+   int checks = 0;
+   int resource_ids[TOTAL_DATE_DIGITS];
+   int day_id;
+
+   for (size_t h = 0; h < sizeof(TEST_HOURS) / sizeof(TEST_HOURS[0]); h++)
+   {
+      struct tm current_time = test_time(TEST_HOURS[h]);
+
+      select_time_glyphs(&current_time, false, resource_ids);
+      for (int i = 0; i < TOTAL_TIME_DIGITS; i++, checks++)
+      {
+         CHECK(resource_ids[i] == EXPECTED_12H[h][i], "12h hour %d glyph %d: got %d, expected %d", TEST_HOURS[h], i, resource_ids[i], EXPECTED_12H[h][i]);
+      }
+
+      select_time_glyphs(&current_time, true, resource_ids);
+      for (int i = 0; i < TOTAL_TIME_DIGITS; i++, checks++)
+      {
+         CHECK(resource_ids[i] == EXPECTED_24H[h][i], "24h hour %d glyph %d: got %d, expected %d", TEST_HOURS[h], i, resource_ids[i], EXPECTED_24H[h][i]);
+      }
+   }
+
+   for (size_t b = 0; b < sizeof(TEST_BATTERIES) / sizeof(TEST_BATTERIES[0]); b++)
+   {
+      select_batt_glyphs(TEST_BATTERIES[b].state, resource_ids);
+      for (int i = 0; i < TOTAL_BATT_DIGITS; i++, checks++)
+      {
+         CHECK(resource_ids[i] == EXPECTED_BATT[b][i], "battery %s glyph %d: got %d, expected %d", TEST_BATTERIES[b].name, i, resource_ids[i], EXPECTED_BATT[b][i]);
+      }
+   }
+
+   struct tm current_time = test_time(0);
+
+   select_date_glyphs(&current_time, &day_id, resource_ids);
+   CHECK(day_id == RESOURCE_ID_IMAGE_DAY_FRI, "day glyph: got %d, expected %d", day_id, RESOURCE_ID_IMAGE_DAY_FRI);
+   checks++;
+   for (int i = 0; i < TOTAL_DATE_DIGITS; i++, checks++)
+   {
+      CHECK(resource_ids[i] == EXPECTED_DATE[i], "date glyph %d: got %d, expected %d", i, resource_ids[i], EXPECTED_DATE[i]);
+   }
+
+   return checks;
+}  // check_glyph_selection()
+
+
+// Let the fields bounce freely for a few ticks from their frozen positions, with the default deltas
+static void check_moved_frame(bool update_golden)
+{
+   struct tm current_time = test_time(9);
+   BatteryChargeState batt_state = TEST_BATTERIES[1].state;
+
+   freeze_timer = 4;
+   render_frame(&current_time, batt_state);
+
+   GRect time_frame = layer_get_frame(time_layer);
+   GRect date_frame = layer_get_frame(date_layer);
+
+   freeze_timer = 0;
+   time_x_delta = 2;
+   time_y_delta = 3;
+   date_x_delta = -3;
+   date_y_delta = -2;
+
+   int created = stub_bitmaps_created;
+   for (int i = 0; i < MOVED_TICKS; i++)
+   {
+      update_moves();
+      render_frame(&current_time, batt_state);
+   }
+
+   // no field reaches an edge within these ticks, so no delta is re-rolled
+   time_frame.origin = GPoint(time_frame.origin.x + (MOVED_TICKS * 2), time_frame.origin.y + (MOVED_TICKS * 3));
+   date_frame.origin = GPoint(date_frame.origin.x - (MOVED_TICKS * 3), date_frame.origin.y - (MOVED_TICKS * 2));
+
+   CHECK(equal_rects(layer_get_frame(time_layer), time_frame), "moved time field at %d,%d, expected %d,%d",
+         layer_get_frame(time_layer).origin.x, layer_get_frame(time_layer).origin.y, time_frame.origin.x, time_frame.origin.y);
+   CHECK(equal_rects(layer_get_frame(date_layer), date_frame), "moved date field at %d,%d, expected %d,%d",
+         layer_get_frame(date_layer).origin.x, layer_get_frame(date_layer).origin.y, date_frame.origin.x, date_frame.origin.y);
+   CHECK(stub_bitmaps_created == created, "moving the fields loaded %d bitmaps", stub_bitmaps_created - created);
+
+   compare_golden("moved", update_golden);
+}  // check_moved_frame()
+
+
+static bool compare_golden(const char *name, bool update)
+{
+   char path[512];
+   char header[32];
+   uint8_t packed[FRAME_BYTES];
+   uint8_t golden[FRAME_BYTES];
+
+   pack_frame(packed);
+   snprintf(path, sizeof(path), "%s/%s.pbm", GOLDEN_DIR, name);
+   snprintf(header, sizeof(header), "P4\n%d %d\n", STUB_SCREEN_WIDTH, STUB_SCREEN_HEIGHT);
+
+   if (update)
+   {
+      FILE *file = fopen(path, "wb");
+      CHECK(file != NULL, "can't write golden frame %s", path);
+      if (file != NULL)
+      {
+         fputs(header, file);
+         fwrite(packed, 1, FRAME_BYTES, file);
+         fclose(file);
+      }
+      return (file != NULL);
+   }
+
+   FILE *file = fopen(path, "rb");
+   if (file == NULL)
+   {
+      CHECK(false, "missing golden frame %s (run 'make golden')", path);
+      return false;
+   }
+
+   char file_header[32] = { 0 };
+   bool ok = (fread(file_header, 1, strlen(header), file) == strlen(header)) && (strcmp(file_header, header) == 0) && (fread(golden, 1, FRAME_BYTES, file) == FRAME_BYTES);
+   fclose(file);
+
+   CHECK(ok, "unreadable golden frame %s", path);
+   if (!ok)
+   {
+      return false;
+   }
+
+   int diff_pixels = 0;
+   for (int i = 0; i < FRAME_BYTES; i++)
+   {
+      diff_pixels += __builtin_popcount(packed[i] ^ golden[i]);
+   }
+
+   CHECK(diff_pixels == 0, "frame %s differs from golden in %d pixels", name, diff_pixels);
+
+   if (diff_pixels != 0)
+   {
+      // keep the actual frame next to the build for inspection
+      snprintf(path, sizeof(path), "%s/%s.actual.pbm", ACTUAL_DIR, name);
+      file = fopen(path, "wb");
+      if (file != NULL)
+      {
+         fputs(header, file);
+         fwrite(packed, 1, FRAME_BYTES, file);
+         fclose(file);
+      }
+   }
+
+   return (diff_pixels == 0);
+}  // compare_golden()
+
+
+static bool equal_rects(GRect a, GRect b)
+{
+   return (a.origin.x == b.origin.x) && (a.origin.y == b.origin.y) && (a.size.w == b.size.w) && (a.size.h == b.size.h);
+}  // equal_rects()
+
+
+// Forget which glyphs are loaded, so the next update reloads every one of them,
+// the way the original single-layer update_display() did on every tick
+static void invalidate_glyph_cache(void)
+{
+   for (int i = 0; i < TOTAL_TIME_DIGITS; i++)
+   {
+      time_digits_resource_id[i] = RESOURCE_ID_INVALID;
+   }
+
+   for (int i = 0; i < TOTAL_DATE_DIGITS; i++)
+   {
+      date_resource_id[i] = RESOURCE_ID_INVALID;
+   }
+
+   for (int i = 0; i < TOTAL_BATT_DIGITS; i++)
+   {
+      batt_resource_id[i] = RESOURCE_ID_INVALID;
+   }
+
+   day_resource_id = RESOURCE_ID_INVALID;
+}  // invalidate_glyph_cache()
+
+
+static bool load_baseline(const char *path, Baseline *baseline)
+{
+   char line[256];
+   char key[64];
+   long value;
+
+   FILE *file = fopen(path, "r");
+   if (file == NULL)
+   {
+      return false;
+   }
+
+   while (fgets(line, sizeof(line), file) != NULL)
+   {
+      if ((line[0] == '#') || (sscanf(line, "%63s %ld", key, &value) != 2))
+      {
+         continue;
+      }
+
+      if (strcmp(key, "frame_allocs") == 0) baseline->frame_allocs = value;
+      else if (strcmp(key, "tick_allocs") == 0) baseline->tick_allocs = value;
+      else if (strcmp(key, "full_allocs") == 0) baseline->full_allocs = value;
+   }
+
+   fclose(file);
+
+   return true;
+}  // load_baseline()
+
+
+static double now_us(void)
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+
+   return (now.tv_sec * 1e6) + (now.tv_nsec / 1e3);
+}  // now_us()
+
+
+// Pack the framebuffer into PBM (P4) order: MSB first, 1 = black
+static void pack_frame(uint8_t packed[FRAME_BYTES])
+{
+   const GColor *pixels = stub_framebuffer();
+   int other_pixels = 0;
+
+   memset(packed, 0, FRAME_BYTES);
+
+   for (int i = 0; i < STUB_SCREEN_WIDTH * STUB_SCREEN_HEIGHT; i++)
+   {
+      if (pixels[i].argb != GColorWhite.argb)
+      {
+         packed[i / 8] |= 0x80 >> (i % 8);
+
+         // e.g. a color glyph palette that was inverted an odd number of times
+         other_pixels += (pixels[i].argb != GColorBlack.argb);
+      }
+   }
+
+   CHECK(other_pixels == 0, "%d pixels are neither black nor white", other_pixels);
+}  // pack_frame()
+
+
+// One tick of the watchface with the given inputs: load changed glyphs, place the layers & draw
+static void render_frame(const struct tm *current_time, BatteryChargeState batt_state)
+{
+   update_images(current_time, batt_state);
+   update_layers();
+   stub_render_window(window);
+}  // render_frame()
+
+
+// Switch night mode the way the select long click does, so color builds invert the loaded glyph palettes
+static void set_night(bool night)
+{
+   if (night_enabled != night)
+   {
+      select_long_click_handler(NULL, NULL);
+   }
+}  // set_night()
+
+
+// Friday 27-Mar-2015 at <hour>:45 (month & day differ, so the date order is visible)
+static struct tm test_time(int hour)
+{
+   struct tm current_time;
+
+   memset(&current_time, 0, sizeof(current_time));
+   current_time.tm_year = 115;
+   current_time.tm_mon = 2;
+   current_time.tm_mday = 27;
+   current_time.tm_wday = 5;
+   current_time.tm_hour = hour;
+   current_time.tm_min = 45;
+
+   return current_time;
+}  // test_time()
+
+
+static bool write_baseline(const char *path, const Baseline *measured)
+{
+   FILE *file = fopen(path, "w");
+   if (file == NULL)
+   {
+      return false;
+   }
+
+   // only host-independent counts go in here, times are compared within a single run
+   fprintf(file, "# Render suite baseline: the run fails if a count goes over its limit.\n");
+   fprintf(file, "# Regenerate with 'make baseline' after an intended change in render cost.\n");
+   fprintf(file, "# Most bitmaps loaded by a single frame of each kind.\n");
+   fprintf(file, "frame_allocs %ld\n", measured->frame_allocs);
+   fprintf(file, "tick_allocs %ld\n", measured->tick_allocs);
+   fprintf(file, "full_allocs %ld\n", measured->full_allocs);
+
+   fclose(file);
+
+   return true;
+}  // write_baseline()
+
+
+int main(int argc, char *argv[])
+{
+   bool update_golden = false;
+   bool update_baseline = false;
+
+   for (int i = 1; i < argc; i++)
+   {
+      if (strcmp(argv[i], "--update-golden") == 0)
+      {
+         update_golden = true;
+      }
+      else if (strcmp(argv[i], "--update-baseline") == 0)
+      {
+         update_baseline = true;
+      }
+      else
+      {
+         fprintf(stderr, "usage: %s [--update-golden] [--update-baseline]\n", argv[0]);
+         return 2;
+      }
+   }
+
+   int checks = check_glyph_selection();
+   printf("glyph selection: %d checks\n", checks);
+
+   init();
+
+   // the splash screen comes up first, with the time & date layers hidden
+   stub_render_window(window);
+   compare_golden("splash", update_golden);
+
+   splash_timer = 0;
+
+   check_moved_frame(update_golden);
+
+   int frames = 0;
+   int frames_matching = 0;
+   long frame_allocs = 0;
+   long tick_allocs = 0;
+   long full_allocs = 0;
+   double total_frame_us = 0;
+   double total_tick_us = 0;
+   double total_full_us = 0;
+
+   for (int clock_24h = 0; clock_24h <= 1; clock_24h++)
+   {
+      for (int night = 0; night <= 1; night++)
+      {
+         for (int month_first = 0; month_first <= 1; month_first++)
+         {
+            for (size_t b = 0; b < sizeof(TEST_BATTERIES) / sizeof(TEST_BATTERIES[0]); b++)
+            {
+               for (size_t h = 0; h < sizeof(TEST_HOURS) / sizeof(TEST_HOURS[0]); h++)
+               {
+                  char name[64];
+                  struct tm current_time = test_time(TEST_HOURS[h]);
+                  BatteryChargeState batt_state = TEST_BATTERIES[b].state;
+
+                  snprintf(name, sizeof(name), "h%02d_%s_%s_%s_%s", TEST_HOURS[h], clock_24h ? "24h" : "12h",
+                           night ? "night" : "day", month_first ? "mdy" : "dmy", TEST_BATTERIES[b].name);
+
+                  clock_24h_style = clock_24h;
+                  time_x_max = clock_24h ? TIME_FIELD_WIDTH_24H : TIME_FIELD_WIDTH_12H;
+                  date_month_first = month_first;
+                  set_night(night);
+
+                  // the frozen layout keeps the fields at fixed positions
+                  freeze_timer = 4;
+
+                  // a tick where the content changed from the previous frame
+                  int created = stub_bitmaps_created;
+                  double start = now_us();
+                  render_frame(&current_time, batt_state);
+                  total_frame_us += now_us() - start;
+                  if (stub_bitmaps_created - created > frame_allocs)
+                  {
+                     frame_allocs = stub_bitmaps_created - created;
+                  }
+
+                  frames++;
+                  if (compare_golden(name, update_golden))
+                  {
+                     frames_matching++;
+                  }
+
+                  // move-only ticks: the fields bounce around, but nothing changed, so no glyph may be reloaded
+                  freeze_timer = 0;
+
+                  double best_us = 1e9;
+                  created = stub_bitmaps_created;
+                  for (int r = 0; r < TICK_REPEATS; r++)
+                  {
+                     GRect time_frame = layer_get_frame(time_layer);
+                     GRect date_frame = layer_get_frame(date_layer);
+
+                     start = now_us();
+                     update_moves();
+                     render_frame(&current_time, batt_state);
+                     double elapsed_us = now_us() - start;
+
+                     if (elapsed_us < best_us)
+                     {
+                        best_us = elapsed_us;
+                     }
+
+                     CHECK(!equal_rects(layer_get_frame(time_layer), time_frame), "frame %s: move-only tick %d left the time field in place", name, r);
+                     CHECK(!equal_rects(layer_get_frame(date_layer), date_frame), "frame %s: move-only tick %d left the date field in place", name, r);
+                  }
+                  total_tick_us += best_us;
+                  CHECK(stub_bitmaps_created == created, "frame %s: move-only ticks loaded %d bitmaps", name, stub_bitmaps_created - created);
+                  if ((stub_bitmaps_created - created) / TICK_REPEATS > tick_allocs)
+                  {
+                     tick_allocs = (stub_bitmaps_created - created) / TICK_REPEATS;
+                  }
+
+                  // the single-layer path moved the fields & reloaded every glyph on every tick
+                  best_us = 1e9;
+                  created = stub_bitmaps_created;
+                  for (int r = 0; r < TICK_REPEATS; r++)
+                  {
+                     invalidate_glyph_cache();
+                     start = now_us();
+                     update_moves();
+                     render_frame(&current_time, batt_state);
+                     double elapsed_us = now_us() - start;
+
+                     if (elapsed_us < best_us)
+                     {
+                        best_us = elapsed_us;
+                     }
+                  }
+                  total_full_us += best_us;
+                  if ((stub_bitmaps_created - created) / TICK_REPEATS > full_allocs)
+                  {
+                     full_allocs = (stub_bitmaps_created - created) / TICK_REPEATS;
+                  }
+
+                  // back in the frozen layout, the reloaded glyphs must draw the same frame
+                  freeze_timer = 4;
+                  render_frame(&current_time, batt_state);
+                  CHECK(compare_golden(name, false) || update_golden, "frame %s changed after a full glyph reload", name);
+               }
+            }
+         }
+      }
+   }
+
+   deinit();
+
+   CHECK(stub_bitmaps_created == stub_bitmaps_destroyed, "bitmap leak: %d created, %d destroyed", stub_bitmaps_created, stub_bitmaps_destroyed);
+
+   Baseline measured = { frame_allocs, tick_allocs, full_allocs };
+   double frame_us = total_frame_us / frames;
+   double tick_us = total_tick_us / frames;
+   double full_us = total_full_us / frames;
+
+   printf("golden frames: %d/%d match%s\n", frames_matching, frames, update_golden ? " (goldens rewritten)" : "");
+   printf("per frame                      mean time   max bitmap loads\n");
+   printf("  content change               %6.0f us   %4ld\n", frame_us, measured.frame_allocs);
+   printf("  move-only tick               %6.0f us   %4ld\n", tick_us, measured.tick_allocs);
+   printf("  full reload (single layer)   %6.0f us   %4ld\n", full_us, measured.full_allocs);
+   printf("move-only tick / full reload: %.2f (limit %.2f)\n", tick_us / full_us, TICK_TIME_RATIO_MAX);
+
+   // absolute times depend on the host & CFLAGS, the ratio between two paths of the same run doesn't
+   CHECK(tick_us <= full_us * TICK_TIME_RATIO_MAX, "move-only tick takes %.2f of a full reload, over %.2f", tick_us / full_us, TICK_TIME_RATIO_MAX);
+
+   if (update_baseline)
+   {
+      CHECK(write_baseline(BASELINE_FILE, &measured), "can't write baseline %s", BASELINE_FILE);
+      printf("baseline rewritten: %s\n", BASELINE_FILE);
+   }
+   else
+   {
+      Baseline baseline = { 0, 0, 0 };
+
+      if (!load_baseline(BASELINE_FILE, &baseline))
+      {
+         CHECK(false, "missing baseline %s (run 'make baseline')", BASELINE_FILE);
+      }
+      else
+      {
+         CHECK(measured.frame_allocs <= baseline.frame_allocs, "content-change bitmap loads %ld over baseline %ld", measured.frame_allocs, baseline.frame_allocs);
+         CHECK(measured.tick_allocs <= baseline.tick_allocs, "move-only tick bitmap loads %ld over baseline %ld", measured.tick_allocs, baseline.tick_allocs);
+         CHECK(measured.full_allocs <= baseline.full_allocs, "full reload bitmap loads %ld over baseline %ld", measured.full_allocs, baseline.full_allocs);
+      }
+   }
+
+   printf("%s (%d failures)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+
+   return (failures == 0) ? 0 : 1;
+}  // main()